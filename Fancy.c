@@ -1,5 +1,9 @@
+#undef FANCY_INLINE                 // The library always exports the hot helpers,
+#define FANCY_HELPERS_IMPLEMENTATION  // which Fancy.h defines.
 #include "Fancy.h"
 
+static int fancyKeyGet(FancyContainer container);  // Key input that keeps patching pool cells.
+
 /* Base ***********************************************************************/
 
 void* fancyError(char* errorDescription) {
@@ -50,21 +54,8 @@ int fancyEnd(const bool wait) {
 
 /* Utils **********************************************************************/
 
-int fancyXGet(FancyContainer container) {
-	return getcurx(container);
-}
-
-int fancyYGet(FancyContainer container) {
-	return getcury(container);
-}
-
-int fancyXMax(FancyContainer container) {
-	return getmaxx(container);
-}
-
-int fancyYMax(FancyContainer container) {
-	return getmaxy(container);
-}
+// fancyXGet, fancyYGet, fancyXMax, fancyYMax, fancyRelativeCenter, fancyAddSecure and
+// fancyMultiplySecure are defined in Fancy.h.
 
 FancyContainer fancyXSet(FancyContainer container, const int x) {
 	wmove(container, fancyYGet(container), x < 0 ? fancyXMax(container) + x : x);
@@ -108,23 +99,6 @@ int fancyHeight(FancyContainer container) {
 	return fancyYMax(container) - fancyYMin(container);
 }
 
-int fancyRelativeCenter(const int parentSize, const int childSize) {
-	const int relativeCenter = (parentSize - childSize) / 2;
-	return relativeCenter < 0 ? 0 : relativeCenter;
-}
-
-int fancyAddSecure(int value1, int value2) {
-	const signed long int result = (signed long int)value1 + (signed long int)value2;
-
-	return result > INT_MAX ? INT_MAX : result < INT_MIN ? INT_MIN : (int)result;
-}
-
-int fancyMultiplySecure(int value1, int value2) {
-	const signed long int result = (signed long int)value1 * (signed long int)value2;
-
-	return result > INT_MAX ? INT_MAX : result < INT_MIN ? INT_MIN : (int)result;
-}
-
 FancyContainer fancyBorderAdd(FancyContainer container) {
 	box(container, 0, 0);
 
@@ -154,13 +128,45 @@ char* fancyScanString(FancyContainer container, const bool echoVisible) {
 	const int remainingSpace = (width * height) - (y * width + x); // All remaining characters of container
 	const int bufferSize = remainingSpace > FANCY_STRING_LIMIT ? FANCY_STRING_LIMIT : remainingSpace;
 
-	char* string = malloc(bufferSize);
+	char* string = malloc(bufferSize > 0 ? bufferSize : 1);
+	bool running = true;
+	int length = 0;
+
+	if (string == NULL) {
+		return fancyError("fancyScanString");
+	}
 
 	fancyCursorVisible(true);
-	fancyEchoVisible(echoVisible);
-	wgetnstr(container, string, bufferSize);
+	fancyEchoVisible(false);  // Characters are echoed here, keys are read with fancyKeyGet.
+
+	while (running) {
+		const int key = fancyKeyGet(container);
+
+		if (key == '\n' || key == '\r' || key == KEY_ENTER || key == ERR) {
+			running = false;
+		} else if (key == KEY_BACKSPACE || key == 127 || key == '\b') {
+			if (length > 0) {
+				const int cursorX = fancyXGet(container);
+				const int cursorY = fancyYGet(container);
+
+				length -= 1;
+				if (echoVisible) {
+					wmove(container, cursorX > 0 ? cursorY : cursorY - 1, cursorX > 0 ? cursorX - 1 : fancyXMax(container) - 1);
+					wdelch(container);
+				}
+			}
+		} else if (key >= ' ' && key <= UCHAR_MAX && length < bufferSize - 1) {
+			string[length++] = (char)key;
+			if (echoVisible) {
+				waddch(container, key);
+			}
+		}
+
+		fancyUpdate(container);
+	}
+
+	string[length] = '\0';
 	fancyCursorVisible(false);
-	fancyEchoVisible(!echoVisible);
 
 	return string;
 }
@@ -176,7 +182,7 @@ int fancyScanInt(FancyContainer container) {
 	fancyPrintXY(container, x, y, "%d", number);
 
 	while (running) {
-		int key = wgetch(container);
+		int key = fancyKeyGet(container);
 		int keyValue = key - 48;
 		switch (keyValue) {
 			/* 0-9 */ case 0 ... 9:
@@ -228,6 +234,664 @@ FancyContainer fancyPrintXY(FancyContainer container, const int x, const int y,
 	return fancyUpdate(container);
 }
 
+/* Text ***********************************************************************/
+
+/**
+ * @brief Line of a text layout.
+ */
+typedef struct {
+	int start;   // Offset of the line in the text.
+	int length;  // Length of the line (without surrounding spaces).
+	bool last;   // Is the last line of its paragraph?
+} FancyTextLine;
+
+/**
+ * @brief Line breaks of a text for a given width.
+ */
+typedef struct {
+	char* text;            // Copy of the text (NULL if the slot is empty).
+	unsigned long hash;    // Hash of the text.
+	int width;             // Width the text was wrapped to.
+	int count;             // Amount of lines.
+	FancyTextLine* lines;  // Lines of the text.
+} FancyTextLayout;
+
+static FancyTextLayout fancyTextCache[FANCY_TEXT_CACHE_SIZE];
+
+static int fancyTextBreak(const char* text, const int width, FancyTextLine* lines) {
+	bool running = width > 0;
+	int position = 0;
+	int count = 0;
+
+	while (running) {
+		bool last = false;
+		int start = position;
+		int end = 0;
+
+		while (text[start] == ' ') {
+			start += 1;  // Spaces at the start of a line are dropped.
+		}
+		position = end = start;
+
+		while (!last) {
+			int wordEnd = position;
+
+			if (text[position] == '\0' || text[position] == '\n') {
+				last = true;
+				continue;
+			}
+			while (text[wordEnd] != '\0' && text[wordEnd] != ' ' && text[wordEnd] != '\n') {
+				wordEnd += 1;
+			}
+			if (wordEnd - start > width) {
+				if (end == start) {
+					end = position = start + width;  // Word longer than the line is split.
+				}
+				break;
+			}
+			end = position = wordEnd;
+			while (text[position] == ' ') {
+				position += 1;
+			}
+		}
+
+		if (lines != NULL) {
+			lines[count] = (FancyTextLine){start, end - start, last};
+		}
+		count += 1;
+
+		if (last) {
+			running = text[position] == '\n';
+			position += 1;
+		}
+	}
+
+	return count;
+}
+
+static FancyTextLayout* fancyTextLayout(const char* text, const int width) {
+	unsigned long hash = 5381;
+	int length = 0;
+	int index = 0;
+
+	while (text[length] != '\0') {
+		hash = hash * 33 + (unsigned char)(text[length] == '\t' ? ' ' : text[length]);  // Tabs are laid out as spaces.
+		length += 1;
+	}
+
+	FancyTextLayout* layout = &fancyTextCache[(hash ^ (unsigned long)width * 2654435761UL) % FANCY_TEXT_CACHE_SIZE];
+
+	if (layout->text != NULL && layout->hash == hash && layout->width == width) {
+		while (text[index] != '\0' && layout->text[index] == (text[index] == '\t' ? ' ' : text[index])) {
+			index += 1;
+		}
+		if (text[index] == layout->text[index]) {
+			return layout;  // Cache hit, line breaks are reused.
+		}
+	}
+
+	free(layout->text);
+	free(layout->lines);
+	layout->text = malloc(length + 1);
+
+	if (layout->text == NULL) {
+		fancyError("fancyTextLayout");
+	}
+
+	index = 0;
+	while (index <= length) {  // ncurses would expand tabs to tab stops, past the wrapped width.
+		layout->text[index] = text[index] == '\t' ? ' ' : text[index];
+		index += 1;
+	}
+
+	layout->hash = hash;
+	layout->width = width;
+	layout->count = fancyTextBreak(layout->text, width, NULL);
+	layout->lines = malloc(sizeof(FancyTextLine) * (layout->count > 0 ? layout->count : 1));
+
+	if (layout->lines == NULL) {
+		fancyError("fancyTextLayout");
+	}
+
+	fancyTextBreak(layout->text, width, layout->lines);
+
+	return layout;
+}
+
+static int fancyTextCut(const char* text, const FancyTextLine line, const int width) {
+	const int ellipsisLength = strlen(FANCY_ELLIPSIS);
+	int length = line.length + ellipsisLength > width ? width - ellipsisLength : line.length;
+
+	if (length <= 0) {
+		return 0;
+	}
+
+	if (length < line.length && text[line.start + length] != ' ') {
+		int space = length;
+
+		while (space > 0 && text[line.start + space - 1] != ' ') {
+			space -= 1;  // Backs up to the last word that fits.
+		}
+		while (space > 0 && text[line.start + space - 1] == ' ') {
+			space -= 1;
+		}
+		length = space > 0 ? space : length;  // A single word is cut anyway.
+	}
+
+	return length;
+}
+
+static void fancyTextLinePrint(FancyContainer container, const int y, const int width, const char* text, const FancyTextLine line, const FancyAlign align, const bool truncated) {
+	const int ellipsisLength = strlen(FANCY_ELLIPSIS);
+	const int length = truncated ? fancyTextCut(text, line, width) : line.length;
+	const int total = truncated ? length + ellipsisLength : length;
+	const int x = align == FANCY_ALIGN_RIGHT ? width - total : align == FANCY_ALIGN_CENTER ? fancyRelativeCenter(width, total) : 0;
+
+	wmove(container, y, 0);
+	wclrtoeol(container);
+
+	if (align == FANCY_ALIGN_JUSTIFY && !line.last && !truncated) {
+		int words = 0;
+		int letters = 0;
+		int index = 0;
+
+		while (index < line.length) {
+			if (text[line.start + index] != ' ') {
+				words += (index == 0 || text[line.start + index - 1] == ' ') ? 1 : 0;
+				letters += 1;
+			}
+			index += 1;
+		}
+
+		if (words > 1) {
+			const int gaps = words - 1;
+			const int spaces = width - letters;
+			int column = 0;
+			int word = 0;
+
+			index = 0;
+			while (index < line.length) {
+				int wordLength = 0;
+
+				while (text[line.start + index] == ' ') {
+					index += 1;
+				}
+				while (index + wordLength < line.length && text[line.start + index + wordLength] != ' ') {
+					wordLength += 1;
+				}
+
+				mvwaddnstr(container, y, column, text + line.start + index, wordLength);
+				column += wordLength + spaces / gaps + (word < spaces % gaps ? 1 : 0);
+				index += wordLength;
+				word += 1;
+			}
+
+			return;
+		}
+	}
+
+	mvwaddnstr(container, y, x < 0 ? 0 : x, text + line.start, length);
+
+	if (truncated) {
+		waddnstr(container, FANCY_ELLIPSIS, width - length);
+	}
+}
+
+static int fancyTextRender(FancyContainer container, const char* text, const FancyAlign align, const int maxLines) {
+	const int width = fancyXMax(container);
+	const int y = fancyYGet(container);
+	const int rows = fancyYMax(container) - y;
+	const int limit = maxLines > 0 && maxLines < rows ? maxLines : rows;
+	const bool scroll = is_scrollok(container);
+	const FancyTextLayout* layout = fancyTextLayout(text, width);
+	const int count = layout->count < limit ? layout->count : limit;
+	int index = 0;
+
+	scrollok(container, false);  // Printing in the last cell must not scroll the container.
+
+	while (index < count) {
+		const bool truncated = index == count - 1 && count < layout->count;
+		fancyTextLinePrint(container, y + index, width, layout->text, layout->lines[index], align, truncated);
+		index += 1;
+	}
+
+	scrollok(container, scroll);
+
+	return count;
+}
+
+int fancyTextLines(const char* text, const int width) {
+	return width > 0 ? fancyTextLayout(text, width)->count : 0;
+}
+
+FancyContainer fancyText(FancyContainer container, const char* text, const FancyAlign align) {
+	return fancyTextClamp(container, text, align, 0);
+}
+
+FancyContainer fancyTextClamp(FancyContainer container, const char* text, const FancyAlign align, const int maxLines) {
+	const int y = fancyYGet(container) + fancyTextRender(container, text, align, maxLines);
+	const int lastY = fancyYMax(container) - 1;
+
+	if (y > lastY && is_scrollok(container)) {
+		wscrl(container, y - lastY);  // Makes room for the next line.
+	}
+
+	return fancyXYSet(container, 0, y > lastY ? lastY : y);
+}
+
+void fancyTextCacheClear() {
+	int index = 0;
+
+	while (index < FANCY_TEXT_CACHE_SIZE) {
+		free(fancyTextCache[index].text);
+		free(fancyTextCache[index].lines);
+		fancyTextCache[index] = (FancyTextLayout){NULL, 0, 0, 0, NULL};
+		index += 1;
+	}
+}
+
+/* Pool ***********************************************************************/
+
+/**
+ * @brief Task of a cell, from submission until its result is patched.
+ */
+typedef struct FancyPoolJob {
+	FancyTask task;             // Task computing the content.
+	void* data;                 // Data given to the task.
+	FancyContainer container;   // FancyContainer of the cell.
+	int x;                      // X Position of the cell.
+	int y;                      // Y Position of the cell.
+	int width;                  // Width of the cell.
+	unsigned long sequence;     // Submission number of the job.
+	char* result;               // Content computed by the task.
+	struct FancyPoolJob* next;  // Next finished job.
+} FancyPoolJob;
+
+/**
+ * @brief Cell with jobs not yet patched.
+ */
+typedef struct {
+	FancyContainer container;  // FancyContainer of the cell.
+	int x;                     // X Position of the cell.
+	int y;                     // Y Position of the cell.
+	unsigned long latest;      // Submission number of the newest job.
+	int pending;               // Jobs not yet patched.
+} FancyPoolCell;
+
+/**
+ * @brief Jobs of a worker, the owner takes the newest and thieves the oldest.
+ */
+typedef struct {
+	pthread_mutex_t lock;  // Guards the queue.
+	FancyPoolJob** jobs;   // Ring buffer of jobs.
+	int capacity;          // Size of the ring buffer.
+	int first;             // Index of the oldest job.
+	int length;            // Amount of jobs.
+} FancyPoolQueue;
+
+/**
+ * @brief Worker thread of a pool.
+ */
+typedef struct {
+	FancyPool pool;    // Pool of the worker.
+	int index;         // Index of the worker (and its queue).
+	pthread_t thread;  // Thread of the worker.
+} FancyPoolWorker;
+
+struct FancyPoolData {
+	pthread_mutex_t lock;            // Guards queued, running and done.
+	pthread_cond_t wake;             // Signals queued jobs to sleeping workers.
+	FancyPoolQueue* queues;          // Queue of each worker.
+	FancyPoolWorker* workers;        // Worker threads.
+	int workersLength;               // Amount of workers.
+	int queued;                      // Jobs waiting in the queues.
+	int next;                        // Queue for the next submission (UI thread only).
+	unsigned long sequence;          // Submission number of the last job (UI thread only).
+	FancyPoolCell* cells;            // Cells with pending jobs (UI thread only).
+	int cellsLength;                 // Amount of cells.
+	int cellsCapacity;               // Allocated cells.
+	bool running;                    // Should workers keep waiting for jobs?
+	FancyPoolJob* done;              // Finished jobs (newest first).
+	struct FancyPoolData* nextPool;  // Next started pool.
+};
+
+static FancyPool fancyPools = NULL;  // Started pools (drained while waiting for keys).
+
+static void fancyPoolQueuePush(FancyPoolQueue* queue, FancyPoolJob* job) {
+	pthread_mutex_lock(&queue->lock);
+
+	if (queue->length == queue->capacity) {
+		const int capacity = queue->capacity > 0 ? queue->capacity * 2 : 16;
+		FancyPoolJob** jobs = malloc(sizeof(FancyPoolJob*) * capacity);
+		int index = 0;
+
+		if (jobs == NULL) {
+			fancyError("fancyPoolQueuePush");
+		}
+		while (index < queue->length) {
+			jobs[index] = queue->jobs[(queue->first + index) % queue->capacity];
+			index += 1;
+		}
+		free(queue->jobs);
+		queue->jobs = jobs;
+		queue->capacity = capacity;
+		queue->first = 0;
+	}
+
+	queue->jobs[(queue->first + queue->length) % queue->capacity] = job;
+	queue->length += 1;
+
+	pthread_mutex_unlock(&queue->lock);
+}
+
+static FancyPoolJob* fancyPoolQueuePop(FancyPoolQueue* queue, const bool steal) {
+	FancyPoolJob* job = NULL;
+
+	pthread_mutex_lock(&queue->lock);
+
+	if (queue->length > 0) {
+		queue->length -= 1;
+		if (steal) {
+			job = queue->jobs[queue->first];
+			queue->first = (queue->first + 1) % queue->capacity;
+		} else {
+			job = queue->jobs[(queue->first + queue->length) % queue->capacity];
+		}
+	}
+
+	pthread_mutex_unlock(&queue->lock);
+
+	return job;
+}
+
+static FancyPoolJob* fancyPoolTake(FancyPool pool, const int index) {
+	FancyPoolJob* job = fancyPoolQueuePop(&pool->queues[index], false);
+	int victim = 1;
+
+	while (job == NULL && victim < pool->workersLength) {
+		job = fancyPoolQueuePop(&pool->queues[(index + victim) % pool->workersLength], true);
+		victim += 1;
+	}
+
+	if (job != NULL) {
+		pthread_mutex_lock(&pool->lock);
+		pool->queued -= 1;
+		pthread_mutex_unlock(&pool->lock);
+	}
+
+	return job;
+}
+
+static void* fancyPoolWork(void* argument) {
+	FancyPoolWorker* worker = argument;
+	FancyPool pool = worker->pool;
+
+	while (true) {
+		FancyPoolJob* job = fancyPoolTake(pool, worker->index);
+
+		if (job == NULL) {
+			bool running = true;
+
+			pthread_mutex_lock(&pool->lock);
+			while (pool->running && pool->queued == 0) {
+				pthread_cond_wait(&pool->wake, &pool->lock);
+			}
+			running = pool->running || pool->queued > 0;
+			pthread_mutex_unlock(&pool->lock);
+
+			if (!running) {
+				return NULL;
+			}
+			continue;
+		}
+
+		job->result = job->task(job->data);
+
+		pthread_mutex_lock(&pool->lock);
+		job->next = pool->done;
+		pool->done = job;
+		pthread_mutex_unlock(&pool->lock);
+	}
+}
+
+static void fancyPoolCellPrint(FancyContainer container, const int x, const int y, const int width, const char* content) {
+	const int cursorX = fancyXGet(container);
+	const int cursorY = fancyYGet(container);
+	const bool scroll = is_scrollok(container);
+
+	scrollok(container, false);  // Printing in the last cell must not scroll the container.
+	mvwprintw(container, y, x, "%-*.*s", width, width, content == NULL ? "" : content);
+	scrollok(container, scroll);
+	wmove(container, cursorY, cursorX);
+}
+
+static FancyPoolCell* fancyPoolCellFind(FancyPool pool, FancyContainer container, const int x, const int y) {
+	int index = 0;
+
+	while (index < pool->cellsLength) {
+		FancyPoolCell* cell = &pool->cells[index];
+		if (cell->container == container && cell->x == x && cell->y == y) {
+			return cell;
+		}
+		index += 1;
+	}
+
+	if (pool->cellsLength == pool->cellsCapacity) {
+		pool->cellsCapacity = pool->cellsCapacity > 0 ? pool->cellsCapacity * 2 : 16;
+		pool->cells = realloc(pool->cells, sizeof(FancyPoolCell) * pool->cellsCapacity);
+		if (pool->cells == NULL) {
+			return fancyError("fancyPoolCellFind");
+		}
+	}
+
+	pool->cells[pool->cellsLength] = (FancyPoolCell){container, x, y, 0, 0};
+
+	return &pool->cells[pool->cellsLength++];
+}
+
+static bool fancyPoolsWaiting() {
+	FancyPool pool = fancyPools;
+
+	while (pool != NULL && pool->cellsLength == 0) {
+		pool = pool->nextPool;
+	}
+
+	return pool != NULL;
+}
+
+static int fancyPoolsDrain() {
+	FancyPool pool = fancyPools;
+	int patched = 0;
+
+	while (pool != NULL) {
+		patched += fancyPoolDrain(pool);
+		pool = pool->nextPool;
+	}
+
+	return patched;
+}
+
+static int fancyKeyGet(FancyContainer container) {
+	int key = ERR;
+
+	if (wgetdelay(container) >= 0) {  // Keeps the caller's nodelay/timeout, polls only blocking reads.
+		key = wgetch(container);
+		fancyPoolsDrain();
+		return key;
+	}
+
+	while (key == ERR && fancyPoolsWaiting()) {
+		wtimeout(container, FANCY_POOL_TICK);  // Wakes up to patch finished cells.
+		key = wgetch(container);
+		wtimeout(container, -1);
+
+		if (fancyPoolsDrain() > 0) {
+			fancyUpdate(container);  // Puts the cursor back in the input.
+		}
+	}
+
+	return key == ERR ? wgetch(container) : key;
+}
+
+FancyPool fancyPoolInit(const int workers) {
+	FancyPool pool = calloc(1, sizeof(struct FancyPoolData));
+	int index = 0;
+
+	if (pool == NULL) {
+		return fancyError("fancyPoolInit");
+	}
+
+	pool->workersLength = workers > 0 ? workers : FANCY_POOL_WORKERS;
+	pool->queues = calloc(pool->workersLength, sizeof(FancyPoolQueue));
+	pool->workers = calloc(pool->workersLength, sizeof(FancyPoolWorker));
+	pool->running = true;
+
+	if (pool->queues == NULL || pool->workers == NULL) {
+		return fancyError("fancyPoolInit");
+	}
+
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->wake, NULL);
+
+	while (index < pool->workersLength) {
+		pthread_mutex_init(&pool->queues[index].lock, NULL);  // Every queue is ready before workers steal.
+		index += 1;
+	}
+
+	index = 0;
+	while (index < pool->workersLength) {
+		pool->workers[index].pool = pool;
+		pool->workers[index].index = index;
+		if (pthread_create(&pool->workers[index].thread, NULL, fancyPoolWork, &pool->workers[index]) != 0) {
+			return fancyError("fancyPoolInit");
+		}
+		index += 1;
+	}
+
+	pool->nextPool = fancyPools;
+	fancyPools = pool;
+
+	return pool;
+}
+
+FancyContainer fancyPoolCell(FancyPool pool, FancyContainer container, const int x, const int y, const int width, FancyTask task, void* data) {
+	FancyPoolJob* job = malloc(sizeof(FancyPoolJob));
+	FancyPoolCell* cell = fancyPoolCellFind(pool, container, x, y);
+
+	if (job == NULL) {
+		return fancyError("fancyPoolCell");
+	}
+
+	*job = (FancyPoolJob){task, data, container, x, y, width, ++pool->sequence, NULL, NULL};
+	cell->latest = job->sequence;
+	cell->pending += 1;
+	fancyPoolCellPrint(container, x, y, width, FANCY_POOL_PLACEHOLDER);
+
+	pthread_mutex_lock(&pool->lock);
+	pool->queued += 1;  // Counted before a worker can take it.
+	pthread_mutex_unlock(&pool->lock);
+
+	fancyPoolQueuePush(&pool->queues[pool->next], job);
+	pool->next = (pool->next + 1) % pool->workersLength;
+
+	pthread_mutex_lock(&pool->lock);
+	pthread_cond_signal(&pool->wake);
+	pthread_mutex_unlock(&pool->lock);
+
+	return fancyUpdate(container);
+}
+
+int fancyPoolDrain(FancyPool pool) {
+	FancyPoolJob* done = NULL;
+	int patched = 0;
+
+	pthread_mutex_lock(&pool->lock);
+	done = pool->done;
+	pool->done = NULL;
+	pthread_mutex_unlock(&pool->lock);
+
+	while (done != NULL) {
+		FancyPoolJob* next = done->next;
+		FancyPoolCell* cell = fancyPoolCellFind(pool, done->container, done->x, done->y);
+
+		if (done->sequence == cell->latest) {  // Results of older submissions of the cell are stale.
+			fancyPoolCellPrint(done->container, done->x, done->y, done->width, done->result);
+			wnoutrefresh(done->container);
+			patched += 1;
+		}
+		if (--cell->pending == 0) {
+			*cell = pool->cells[--pool->cellsLength];
+		}
+
+		free(done->result);
+		free(done);
+		done = next;
+	}
+
+	if (patched > 0) {
+		doupdate();  // All patched cells are shown in the same frame.
+	}
+
+	return patched;
+}
+
+int fancyPoolPending(FancyPool pool) {
+	return pool->cellsLength;
+}
+
+void fancyPoolEnd(FancyPool pool) {
+	FancyPool* link = &fancyPools;
+	FancyPoolJob* job = NULL;
+	int discarded = 0;
+	int index = 0;
+
+	while (index < pool->workersLength) {  // Discards the queued jobs.
+		while ((job = fancyPoolQueuePop(&pool->queues[index], false)) != NULL) {
+			free(job);
+			discarded += 1;
+		}
+		index += 1;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	pool->queued -= discarded;
+	pool->running = false;
+	pthread_cond_broadcast(&pool->wake);
+	pthread_mutex_unlock(&pool->lock);
+
+	index = 0;
+	while (index < pool->workersLength) {  // Running workers may still steal from any queue.
+		pthread_join(pool->workers[index].thread, NULL);
+		index += 1;
+	}
+
+	index = 0;
+	while (index < pool->workersLength) {
+		pthread_mutex_destroy(&pool->queues[index].lock);
+		free(pool->queues[index].jobs);
+		index += 1;
+	}
+
+	while (pool->done != NULL) {
+		job = pool->done->next;
+		free(pool->done->result);
+		free(pool->done);
+		pool->done = job;
+	}
+
+	while (*link != pool) {
+		link = &(*link)->nextPool;
+	}
+	*link = pool->nextPool;
+
+	pthread_cond_destroy(&pool->wake);
+	pthread_mutex_destroy(&pool->lock);
+	free(pool->queues);
+	free(pool->workers);
+	free(pool->cells);
+	free(pool);
+}
+
 /* Containers *****************************************************************/
 
 FancyContainer fancyContainer(FancyContainer parent, const int x, const int y, const int width, const int height) {
@@ -340,7 +1004,7 @@ int fancyInputMenu(FancyContainer parent, const char* choices[]) {
 			index += 1;
 		}
 
-		key = wgetch(parent);
+		key = fancyKeyGet(parent);
 		choice = (key == KEY_UP) ? (choice - 1 < 0 ? choicesLength : choice) - 1
 		                         : (key == KEY_DOWN) ? choice + 1 >= choicesLength ? 0 : choice + 1 : choice;
 		running = (key != 10);
@@ -350,3 +1014,340 @@ int fancyInputMenu(FancyContainer parent, const char* choices[]) {
 
 	return choice;
 }
+
+/* Tree ***********************************************************************/
+
+/**
+ * @brief Types of FancyTree nodes.
+ */
+typedef enum {
+	FANCY_NODE_CONTAINER,
+	FANCY_NODE_TEXT,
+	FANCY_NODE_MENU,
+	FANCY_NODE_INPUT
+} FancyNodeType;
+
+/**
+ * @brief Node of a FancyTree frame.
+ */
+typedef struct {
+	FancyNodeType type;     // Type of the node.
+	int parent;             // Index of the parent container node (-1 for the root).
+	int x;                  // X Position in the parent.
+	int y;                  // Y Position in the parent.
+	int width;              // Width (in cols).
+	int height;             // Height (in rows).
+	int left;               // X Position in the root.
+	int top;                // Y Position in the root.
+	int value;              // Highlighted choice (menus) or alignment (texts).
+	char* content;          // Strings of the node, joined by '\0'.
+	int contentLength;      // Length of the content.
+	bool created;           // Containers of the node were created this frame.
+	bool changed;           // Content changed since the previous frame.
+	bool damaged;           // Overlapped by an erased or rendered node.
+	FancyContainer frame;   // Outer container (NULL if it doesn't fit in the parent).
+	FancyContainer window;  // Inner container (children or content).
+} FancyNode;
+
+struct FancyTreeData {
+	FancyContainer root;   // FancyContainer of the tree.
+	FancyNode* nodes;      // Nodes of the frame being described (in pre-order).
+	int length;            // Amount of nodes.
+	int capacity;          // Allocated nodes.
+	FancyNode* previous;   // Nodes of the previous frame.
+	int previousLength;    // Amount of previous nodes.
+	int previousCapacity;  // Allocated previous nodes.
+	int current;           // Index of the open container node (-1 for the root).
+};
+
+static FancyTree fancyNodeAdd(FancyTree tree, const FancyNodeType type, const int x, const int y, const int width, const int height, const int value, const char* strings[], const int stringsLength) {
+	FancyNode* node = NULL;
+	int contentLength = 0;
+	int index = 0;
+
+	if (tree->length == tree->capacity) {
+		tree->capacity = tree->capacity > 0 ? tree->capacity * 2 : 16;
+		tree->nodes = realloc(tree->nodes, sizeof(FancyNode) * tree->capacity);
+		if (tree->nodes == NULL) {
+			return fancyError("fancyNodeAdd");
+		}
+	}
+
+	while (index < stringsLength) {
+		contentLength += strlen(strings[index] == NULL ? "" : strings[index]) + 1;
+		index += 1;
+	}
+
+	node = &tree->nodes[tree->length++];
+	*node = (FancyNode){type, tree->current, x, y, width, height, x, y, value, malloc(contentLength + 1), contentLength, false, false, false, NULL, NULL};
+
+	if (node->parent >= 0) {  // Children are placed inside the padding of their container.
+		node->left += tree->nodes[node->parent].left + FANCY_PADDING;
+		node->top += tree->nodes[node->parent].top + FANCY_PADDING;
+	}
+
+	if (node->content == NULL) {
+		return fancyError("fancyNodeAdd");
+	}
+
+	contentLength = 0;
+	index = 0;
+	while (index < stringsLength) {
+		const int length = strlen(strings[index] == NULL ? "" : strings[index]) + 1;
+		memcpy(node->content + contentLength, strings[index] == NULL ? "" : strings[index], length);
+		contentLength += length;
+		index += 1;
+	}
+
+	return tree;
+}
+
+static int fancyNodeFit(const int position, const int size, FancyContainer parent, const bool horizontal) {
+	const int parentSize = parent == NULL ? 0 : horizontal ? fancyXMax(parent) : fancyYMax(parent);
+
+	return position + size > parentSize ? parentSize - position : size;  // Clamped to the parent.
+}
+
+static bool fancyNodeSame(const FancyNode* node, const FancyNode* old, FancyContainer parent) {
+	return old->frame != NULL && old->type == node->type && old->parent == node->parent && old->x == node->x && old->y == node->y && old->width == node->width && old->height == node->height &&
+	       fancyXMax(old->frame) == fancyNodeFit(node->x, node->width, parent, true) && fancyYMax(old->frame) == fancyNodeFit(node->y, node->height, parent, false);  // Parent resized.
+}
+
+static bool fancyNodeOverlap(const FancyNode* node, const FancyNode* other) {
+	return node->left < other->left + other->width && other->left < node->left + node->width && node->top < other->top + other->height && other->top < node->top + node->height;
+}
+
+static bool fancyNodeDescends(FancyTree tree, const int index, const int ancestor) {
+	int parent = tree->nodes[index].parent;
+
+	while (parent > ancestor) {
+		parent = tree->nodes[parent].parent;
+	}
+
+	return parent == ancestor;
+}
+
+static void fancyNodeDamage(FancyTree tree, const FancyNode* damaged, const int from, const int skip) {
+	int index = from;
+
+	while (index < tree->length) {
+		FancyNode* node = &tree->nodes[index];
+
+		if (!node->changed && fancyNodeOverlap(node, damaged) && (skip < 0 || !fancyNodeDescends(tree, index, skip))) {
+			node->changed = node->damaged = true;  // Rendered again over the damaged area.
+		}
+		index += 1;
+	}
+}
+
+static void fancyNodeDelete(FancyNode* node) {
+	werase(node->frame);
+	wnoutrefresh(node->frame);
+	if (node->window != node->frame && node->window != NULL) {
+		delwin(node->window);
+	}
+	delwin(node->frame);
+	node->frame = node->window = NULL;
+}
+
+static void fancyNodeCreate(FancyNode* node, FancyContainer parent) {
+	const int width = fancyNodeFit(node->x, node->width, parent, true);
+	const int height = fancyNodeFit(node->y, node->height, parent, false);
+	const int padding = node->type == FANCY_NODE_CONTAINER || node->type == FANCY_NODE_INPUT ? FANCY_PADDING : 0;
+
+	if (width <= 0 || height <= 0 || node->x < 0 || node->y < 0) {
+		return;  // Doesn't fit in the parent (nor do its children).
+	}
+
+	node->frame = node->window = derwin(parent, height, width, node->y, node->x);
+
+	if (padding > 0 && node->frame != NULL) {
+		node->window = width > padding * 2 && height > padding * 2 ? derwin(node->frame, height - padding * 2, width - padding * 2, padding, padding) : NULL;
+	}
+}
+
+static void fancyNodeRender(FancyNode* node) {
+	const char* content = node->content;
+	int index = 0;
+
+	switch (node->type) {
+		case FANCY_NODE_CONTAINER:
+		case FANCY_NODE_INPUT:
+			if (node->created || node->damaged) {
+				werase(node->frame);  // Children are rendered again too.
+			}
+			box(node->frame, 0, 0);
+			if (fancyXMax(node->frame) > 2) {  // n < 0 would print the whole title.
+				mvwaddnstr(node->frame, 0, 1, content, fancyXMax(node->frame) - 2);
+			}
+			wnoutrefresh(node->frame);
+			if (node->type == FANCY_NODE_INPUT && node->window != NULL) {
+				werase(node->window);
+				mvwaddnstr(node->window, 0, 0, content + strlen(content) + 1, fancyXMax(node->window));
+				wnoutrefresh(node->window);
+			}
+			break;
+		case FANCY_NODE_TEXT:
+			werase(node->window);
+			wmove(node->window, 0, 0);
+			fancyTextRender(node->window, content, (FancyAlign)node->value, 0);
+			wnoutrefresh(node->window);
+			break;
+		case FANCY_NODE_MENU:
+			werase(node->window);
+			while (index < node->height && content < node->content + node->contentLength) {
+				const int effect = index == node->value ? FANCY_MENU_HIGHLIGHTED : A_NORMAL;
+				wattron(node->window, effect);
+				mvwprintw(node->window, index, 0, "%s%s ", FANCY_LIST_CHAR, content);
+				wattroff(node->window, effect);
+				content += strlen(content) + 1;
+				index += 1;
+			}
+			wnoutrefresh(node->window);
+			break;
+	}
+}
+
+FancyTree fancyTreeInit(FancyContainer root) {
+	FancyTree tree = calloc(1, sizeof(struct FancyTreeData));
+
+	if (tree == NULL) {
+		return fancyError("fancyTreeInit");
+	}
+
+	tree->root = root;
+	tree->current = -1;
+
+	return tree;
+}
+
+FancyTree fancyTreeBegin(FancyTree tree) {
+	FancyNode* nodes = tree->previous;
+	const int capacity = tree->previousCapacity;
+	int index = 0;
+
+	while (index < tree->previousLength) {  // Containers were moved or deleted by fancyTreeEnd.
+		free(tree->previous[index].content);
+		index += 1;
+	}
+
+	tree->previous = tree->nodes;
+	tree->previousLength = tree->length;
+	tree->previousCapacity = tree->capacity;
+	tree->nodes = nodes;
+	tree->capacity = capacity;
+	tree->length = 0;
+	tree->current = -1;
+
+	return tree;
+}
+
+FancyTree fancyNodeContainer(FancyTree tree, const int x, const int y, const int width, const int height, const char* title) {
+	const char* strings[] = {title};
+
+	fancyNodeAdd(tree, FANCY_NODE_CONTAINER, x, y, width, height, 0, strings, 1);
+	tree->current = tree->length - 1;
+
+	return tree;
+}
+
+FancyTree fancyNodeEnd(FancyTree tree) {
+	tree->current = tree->current < 0 ? -1 : tree->nodes[tree->current].parent;
+
+	return tree;
+}
+
+FancyTree fancyNodeText(FancyTree tree, const int x, const int y, const int width, const int height, const char* text, const FancyAlign align) {
+	const char* strings[] = {text};
+
+	return fancyNodeAdd(tree, FANCY_NODE_TEXT, x, y, width, height, align, strings, 1);
+}
+
+FancyTree fancyNodeMenu(FancyTree tree, const int x, const int y, const char* choices[], const int choice) {
+	const int choicesLength = fancyArrayLength((void*)choices);
+	int width = 0;
+	int index = 0;
+
+	while (index < choicesLength) {
+		const int length = strlen(FANCY_LIST_CHAR) + strlen(choices[index]) + 1;
+		width = length > width ? length : width;
+		index += 1;
+	}
+
+	return fancyNodeAdd(tree, FANCY_NODE_MENU, x, y, width, choicesLength, choice, choices, choicesLength);
+}
+
+FancyTree fancyNodeInput(FancyTree tree, const int x, const int y, const int width, const char* label, const char* value) {
+	const char* strings[] = {label, value};
+
+	return fancyNodeAdd(tree, FANCY_NODE_INPUT, x, y, width, FANCY_PADDING * 2 + FANCY_INPUT_HEIGHT, 0, strings, 2);
+}
+
+int fancyTreeEnd(FancyTree tree) {
+	int rendered = 0;
+	int deleted = 0;
+	int index = 0;
+
+	while (index < tree->length) {  // Reuses the containers of unchanged nodes.
+		FancyNode* node = &tree->nodes[index];
+		FancyNode* old = index < tree->previousLength ? &tree->previous[index] : NULL;
+		const bool parentCreated = node->parent >= 0 && tree->nodes[node->parent].created;
+
+		if (old != NULL && !parentCreated && fancyNodeSame(node, old, node->parent < 0 ? tree->root : tree->nodes[node->parent].window)) {
+			node->frame = old->frame;
+			node->window = old->window;
+			node->changed = node->value != old->value || node->contentLength != old->contentLength || memcmp(node->content, old->content, node->contentLength) != 0;
+			old->frame = old->window = NULL;
+		} else {
+			node->created = node->changed = true;
+		}
+		index += 1;
+	}
+
+	index = tree->previousLength;
+	while (index-- > 0) {  // Children are deleted before their parents.
+		if (tree->previous[index].frame != NULL) {
+			fancyNodeDamage(tree, &tree->previous[index], 0, -1);  // Erasing also clears overlapped nodes.
+			fancyNodeDelete(&tree->previous[index]);
+			deleted += 1;
+		}
+	}
+
+	index = 0;
+	while (index < tree->length) {  // Nodes drawn later are on top of the rendered ones.
+		if (tree->nodes[index].changed) {
+			fancyNodeDamage(tree, &tree->nodes[index], index + 1, tree->nodes[index].created || tree->nodes[index].damaged ? -1 : index);
+		}
+		index += 1;
+	}
+
+	index = 0;
+	while (index < tree->length) {
+		FancyNode* node = &tree->nodes[index];
+
+		if (node->created) {
+			fancyNodeCreate(node, node->parent < 0 ? tree->root : tree->nodes[node->parent].window);
+		}
+		if (node->changed && node->frame != NULL) {
+			fancyNodeRender(node);
+			rendered += 1;
+		}
+		index += 1;
+	}
+
+	if (rendered > 0 || deleted > 0) {
+		doupdate();  // All changed nodes are shown in the same frame.
+	}
+
+	return rendered;
+}
+
+void fancyTreeFree(FancyTree tree) {
+	fancyTreeBegin(tree);  // Frees the previous frame and keeps the current one as previous.
+	fancyTreeEnd(tree);    // Deletes all containers of the (empty) frame.
+	fancyTreeBegin(tree);
+
+	free(tree->nodes);
+	free(tree->previous);
+	free(tree);
+}
@@ -1,5 +1,6 @@
 #include <limits.h>
 #include <ncurses.h>
+#include <pthread.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -19,6 +20,19 @@
 #define FANCY_STRING_LIMIT 256            // String upper limit
 #define FANCY_MENU_HIGHLIGHTED A_REVERSE  // Effect for highlighted menu items.
 #define FANCY_END "_FANCY_END"            // End marker for lists.
+#define FANCY_ELLIPSIS "..."              // Suffix for truncated text.
+#define FANCY_TEXT_CACHE_SIZE 64          // Cached text layouts (line breaks).
+#define FANCY_POOL_WORKERS 4              // Default amount of pool workers.
+#define FANCY_POOL_PLACEHOLDER "..."      // Content of cells waiting for a result.
+#define FANCY_POOL_TICK 50                // Milliseconds between result checks on inputs.
+
+/* Build **********************************************************************/
+
+#ifdef FANCY_INLINE  // Hot helpers are defined in this header (see "Helpers"), for apps only.
+#define FANCY_HELPER static inline
+#else
+#define FANCY_HELPER
+#endif
 
 /* Types **********************************************************************/
 
@@ -27,6 +41,32 @@
  */
 typedef WINDOW* FancyContainer;
 
+/**
+ * @brief Horizontal alignment for text lines.
+ */
+typedef enum {
+	FANCY_ALIGN_LEFT,
+	FANCY_ALIGN_CENTER,
+	FANCY_ALIGN_RIGHT,
+	FANCY_ALIGN_JUSTIFY
+} FancyAlign;
+
+/**
+ * @brief Task computing the content of a cell (runs on a worker thread).
+ * Must not call ncurses, returns a string allocated with malloc (freed by the pool) or NULL.
+ */
+typedef char* (*FancyTask)(void* data);
+
+/**
+ * @brief Pool of worker threads computing cell contents.
+ */
+typedef struct FancyPoolData* FancyPool;
+
+/**
+ * @brief Retained tree of nodes, only changed nodes are rendered.
+ */
+typedef struct FancyTreeData* FancyTree;
+
 /* Base ***********************************************************************/
 
 /**
@@ -96,7 +136,7 @@ int fancyEnd(const bool wait);
  * @param container FancyContainer to be evaluated.
  * @return int Current X value.
  */
-int fancyXGet(FancyContainer container);
+FANCY_HELPER int fancyXGet(FancyContainer container);
 
 /**
  * @brief Get current Y position for given FancyContainer.
@@ -104,7 +144,7 @@ int fancyXGet(FancyContainer container);
  * @param container FancyContainer to be evaluated.
  * @return int Current Y value.
  */
-int fancyYGet(FancyContainer container);
+FANCY_HELPER int fancyYGet(FancyContainer container);
 
 /**
  * @brief Get max X position for given FancyContainer.
@@ -112,7 +152,7 @@ int fancyYGet(FancyContainer container);
  * @param container FancyContainer to be evaluated.
  * @return int Max X value.
  */
-int fancyXMax(FancyContainer container);
+FANCY_HELPER int fancyXMax(FancyContainer container);
 
 /**
  * @brief Get max Y position for given FancyContainer.
@@ -120,7 +160,7 @@ int fancyXMax(FancyContainer container);
  * @param container FancyContainer to be evaluated.
  * @return int Max Y value.
  */
-int fancyYMax(FancyContainer container);
+FANCY_HELPER int fancyYMax(FancyContainer container);
 
 /**
  * @brief Set current X position for given FancyContainer.
@@ -189,7 +229,7 @@ int fancyHeight(FancyContainer container);
  * @param childSize Child size (width or height).
  * @return int Difference value.
  */
-int fancyRelativeCenter(const int parentSize, const int childSize);
+FANCY_HELPER int fancyRelativeCenter(const int parentSize, const int childSize);
 
 /**
  * @brief Securely add 2 int values.
@@ -198,7 +238,7 @@ int fancyRelativeCenter(const int parentSize, const int childSize);
  * @param value2 Value 2 to be added.
  * @return int Secure result.
  */
-int fancyAddSecure(int value1, int value2);
+FANCY_HELPER int fancyAddSecure(int value1, int value2);
 
 /**
  * @brief Securely multiply 2 int values.
@@ -207,7 +247,7 @@ int fancyAddSecure(int value1, int value2);
  * @param value2 Value 2 to be multiplied.
  * @return int Secure result.
  */
-int fancyMultiplySecure(int value1, int value2);
+FANCY_HELPER int fancyMultiplySecure(int value1, int value2);
 
 /**
  * @brief Add border to given FancyContainer.
@@ -274,6 +314,100 @@ FancyContainer fancyPrint(FancyContainer container, const char* format, ...);
  */
 FancyContainer fancyPrintXY(FancyContainer container, const int x, const int y, const char* format, ...);
 
+/* Text ***********************************************************************/
+
+/**
+ * @brief Get the amount of lines of given text word wrapped to given width.
+ *
+ * @param text Text to be measured.
+ * @param width Width (in cols) to wrap to.
+ * @return int Amount of lines.
+ */
+int fancyTextLines(const char* text, const int width);
+
+/**
+ * @brief Print word wrapped and aligned text from the current line of given FancyContainer.
+ * Text that doesn't fit in the remaining lines is truncated with FANCY_ELLIPSIS.
+ * The cursor ends at the start of the next line (scrolling if it was the last one, or
+ * on the last line if the container doesn't scroll).
+ *
+ * @param container FancyContainer to be printed on.
+ * @param text Text to be printed.
+ * @param align Alignment of the lines.
+ * @return FancyContainer Updated FancyContainer.
+ */
+FancyContainer fancyText(FancyContainer container, const char* text, const FancyAlign align);
+
+/**
+ * @brief Print word wrapped and aligned text from the current line of given FancyContainer,
+ * truncated with FANCY_ELLIPSIS to given amount of lines.
+ * The cursor ends at the start of the next line (scrolling if it was the last one, or
+ * on the last line if the container doesn't scroll).
+ *
+ * @param container FancyContainer to be printed on.
+ * @param text Text to be printed.
+ * @param align Alignment of the lines.
+ * @param maxLines Max amount of lines (0 for all remaining lines).
+ * @return FancyContainer Updated FancyContainer.
+ */
+FancyContainer fancyTextClamp(FancyContainer container, const char* text, const FancyAlign align, const int maxLines);
+
+/**
+ * @brief Free all cached text layouts.
+ */
+void fancyTextCacheClear();
+
+/* Pool ***********************************************************************/
+
+/**
+ * @brief Starts and returns a FancyPool.
+ *
+ * @param workers Amount of worker threads (0 for FANCY_POOL_WORKERS).
+ * @return FancyPool New FancyPool.
+ */
+FancyPool fancyPoolInit(const int workers);
+
+/**
+ * @brief Print a placeholder cell in given position (x, y) of given FancyContainer and
+ * submits a task to the FancyPool to compute its content.
+ * Submitting a cell again discards the results of its older tasks.
+ *
+ * @param pool FancyPool to submit the task to.
+ * @param container FancyContainer of the cell (must outlive the task).
+ * @param x X Position.
+ * @param y Y Position.
+ * @param width Width (in cols) of the cell.
+ * @param task Task computing the content of the cell.
+ * @param data Data given to the task.
+ * @return FancyContainer Updated FancyContainer.
+ */
+FancyContainer fancyPoolCell(FancyPool pool, FancyContainer container, const int x, const int y, const int width, FancyTask task, void* data);
+
+/**
+ * @brief Patch the cells of all finished tasks of given FancyPool in a single screen update.
+ * Inputs and menus do this while waiting for keys.
+ *
+ * @param pool FancyPool to be drained.
+ * @return int Amount of patched cells.
+ */
+int fancyPoolDrain(FancyPool pool);
+
+/**
+ * @brief Get the amount of cells of given FancyPool waiting to be patched (a cell submitted
+ * again before its result arrived counts once).
+ *
+ * @param pool FancyPool to be evaluated.
+ * @return int Amount of waiting cells.
+ */
+int fancyPoolPending(FancyPool pool);
+
+/**
+ * @brief Discards the queued tasks, waits for the running ones and frees given FancyPool.
+ *
+ * @param pool FancyPool to be ended.
+ */
+void fancyPoolEnd(FancyPool pool);
+
 /* Containers *****************************************************************/
 
 /**
@@ -394,4 +528,157 @@ char* fancyInputPassword(FancyContainer parent, const char* label);
  */
 int fancyInputMenu(FancyContainer parent, const char* choices[]);
 
+/* Tree ***********************************************************************/
+
+/**
+ * @brief Creates a new FancyTree rendering in given FancyContainer.
+ *
+ * @param root FancyContainer of the FancyTree.
+ * @return FancyTree New FancyTree.
+ */
+FancyTree fancyTreeInit(FancyContainer root);
+
+/**
+ * @brief Starts describing a new frame of given FancyTree.
+ *
+ * @param tree FancyTree to be described.
+ * @return FancyTree Updated FancyTree.
+ */
+FancyTree fancyTreeBegin(FancyTree tree);
+
+/**
+ * @brief Adds a container node with border (and title) and opens it, following nodes
+ * are its children until fancyNodeEnd.
+ *
+ * @param tree FancyTree being described.
+ * @param x X position
+ * @param y Y Position.
+ * @param width Width (in cols).
+ * @param height Height (in rows).
+ * @param title Title of the container (NULL for none).
+ * @return FancyTree Updated FancyTree.
+ */
+FancyTree fancyNodeContainer(FancyTree tree, const int x, const int y, const int width, const int height, const char* title);
+
+/**
+ * @brief Closes the last opened container node.
+ *
+ * @param tree FancyTree being described.
+ * @return FancyTree Updated FancyTree.
+ */
+FancyTree fancyNodeEnd(FancyTree tree);
+
+/**
+ * @brief Adds a text node (word wrapped and aligned, see fancyText).
+ *
+ * @param tree FancyTree being described.
+ * @param x X position
+ * @param y Y Position.
+ * @param width Width (in cols).
+ * @param height Height (in rows).
+ * @param text Text of the node.
+ * @param align Alignment of the lines.
+ * @return FancyTree Updated FancyTree.
+ */
+FancyTree fancyNodeText(FancyTree tree, const int x, const int y, const int width, const int height, const char* text, const FancyAlign align);
+
+/**
+ * @brief Adds a menu node with the given choice highlighted.
+ *
+ * @param tree FancyTree being described.
+ * @param x X position
+ * @param y Y Position.
+ * @param choices Array of strings for the choices, must have a FANCY_END.
+ * @param choice Index of the highlighted choice.
+ * @return FancyTree Updated FancyTree.
+ */
+FancyTree fancyNodeMenu(FancyTree tree, const int x, const int y, const char* choices[], const int choice);
+
+/**
+ * @brief Adds an input node (labeled box) showing given value.
+ *
+ * @param tree FancyTree being described.
+ * @param x X position
+ * @param y Y Position.
+ * @param width Width (in cols).
+ * @param label Label of the input.
+ * @param value Value shown in the input.
+ * @return FancyTree Updated FancyTree.
+ */
+FancyTree fancyNodeInput(FancyTree tree, const int x, const int y, const int width, const char* label, const char* value);
+
+/**
+ * @brief Diffs the described frame against the previous one and renders only the changed
+ * nodes in a single screen update.
+ *
+ * @param tree FancyTree being described.
+ * @return int Amount of rendered nodes.
+ */
+int fancyTreeEnd(FancyTree tree);
+
+/**
+ * @brief Deletes the containers of all nodes and frees given FancyTree.
+ *
+ * @param tree FancyTree to be freed.
+ */
+void fancyTreeFree(FancyTree tree);
+
+/* Helpers ********************************************************************/
+
+// Defined here to be inlined in every translation unit when FANCY_INLINE is set.
+#if defined(FANCY_INLINE) || defined(FANCY_HELPERS_IMPLEMENTATION)
+
+FANCY_HELPER int fancyXGet(FancyContainer container) {
+	return getcurx(container);
+}
+
+FANCY_HELPER int fancyYGet(FancyContainer container) {
+	return getcury(container);
+}
+
+FANCY_HELPER int fancyXMax(FancyContainer container) {
+	return getmaxx(container);
+}
+
+FANCY_HELPER int fancyYMax(FancyContainer container) {
+	return getmaxy(container);
+}
+
+FANCY_HELPER int fancyRelativeCenter(const int parentSize, const int childSize) {
+	const int relativeCenter = (parentSize - childSize) / 2;
+	return relativeCenter < 0 ? 0 : relativeCenter;
+}
+
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)  // Compiler overflow builtins.
+
+FANCY_HELPER int fancyAddSecure(int value1, int value2) {
+	int result = 0;
+
+	return __builtin_add_overflow(value1, value2, &result) ? (value1 < 0 ? INT_MIN : INT_MAX) : result;
+}
+
+FANCY_HELPER int fancyMultiplySecure(int value1, int value2) {
+	int result = 0;
+
+	return __builtin_mul_overflow(value1, value2, &result) ? ((value1 < 0) != (value2 < 0) ? INT_MIN : INT_MAX) : result;
+}
+
+#else
+
+FANCY_HELPER int fancyAddSecure(int value1, int value2) {
+	const long long int result = (long long int)value1 + (long long int)value2;
+
+	return result > INT_MAX ? INT_MAX : result < INT_MIN ? INT_MIN : (int)result;
+}
+
+FANCY_HELPER int fancyMultiplySecure(int value1, int value2) {
+	const long long int result = (long long int)value1 * (long long int)value2;
+
+	return result > INT_MAX ? INT_MAX : result < INT_MIN ? INT_MIN : (int)result;
+}
+
+#endif
+
+#endif
+
 #endif  // FANCY_H
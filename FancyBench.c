@@ -0,0 +1,75 @@
+#include <time.h>
+#include "Fancy.h"
+
+/* Settings *******************************************************************/
+
+#define FANCY_BENCH_ITERATIONS 50000000  // Calls per helper.
+
+#ifdef FANCY_INLINE
+#define FANCY_BENCH_MODE "FANCY_INLINE"
+#else
+#define FANCY_BENCH_MODE "out-of-line"
+#endif
+
+/* Bench **********************************************************************/
+
+volatile int fancyBenchSink = 0;  // Keeps results alive.
+volatile int fancyBenchSeed = 7;  // Keeps inputs unknown at compile time.
+
+/**
+ * @brief Print the time per call since given start.
+ *
+ * @param name Name of the helper(s).
+ * @param start Clock at the start.
+ * @param calls Helper calls per iteration.
+ */
+void fancyBenchReport(const char* name, const clock_t start, const int calls) {
+	const double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+	printf("%-40s %6.2f ns/call\n", name, seconds * 1e9 / ((double)FANCY_BENCH_ITERATIONS * calls));
+}
+
+int main() {
+	FILE* output = fopen("/dev/null", "w");
+	FancyContainer container = NULL;
+	const int seed = fancyBenchSeed;
+	clock_t start = 0;
+	int result = 0;
+	int index = 0;
+
+	if (output == NULL || newterm("vt100", output, stdin) == NULL) {
+		fancyError("fancyBench");
+	}
+	container = newwin(24, 80, 0, 0);
+
+	printf("Fancy helpers (%s)\n", FANCY_BENCH_MODE);
+
+	start = clock();
+	for (index = 0; index < FANCY_BENCH_ITERATIONS; index++) {
+		result += fancyXGet(container) + fancyYGet(container) + fancyXMax(container) + fancyYMax(container);
+	}
+	fancyBenchReport("fancyXGet/fancyYGet/fancyXMax/fancyYMax", start, 4);
+
+	start = clock();
+	for (index = 0; index < FANCY_BENCH_ITERATIONS; index++) {
+		result += fancyRelativeCenter(index, seed);
+	}
+	fancyBenchReport("fancyRelativeCenter", start, 1);
+
+	start = clock();
+	for (index = 0; index < FANCY_BENCH_ITERATIONS; index++) {
+		result = fancyAddSecure(result, index);
+	}
+	fancyBenchReport("fancyAddSecure", start, 1);
+
+	start = clock();
+	for (index = 0; index < FANCY_BENCH_ITERATIONS; index++) {
+		result = fancyAddSecure(fancyMultiplySecure(result, 10), index % 10 + seed);  // fancyScanInt keystroke.
+	}
+	fancyBenchReport("fancyMultiplySecure + fancyAddSecure", start, 2);
+
+	fancyBenchSink = result;
+	delwin(container);
+	endwin();
+
+	return 0;
+}